@@ -28,6 +28,10 @@
 
 #include "SerialDisplay.h"
 
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
 // ----------------------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------------------
 
@@ -37,6 +41,7 @@ SerialDisplay::SerialDisplay(int pinData, int pinClock, byte qty){
   _pinData = pinData;
   _pinClock = pinClock;
   _pinOE = -1; // default
+  _pinLoopback = -1; // default
   pinMode(_pinData, OUTPUT);
   pinMode(_pinClock, OUTPUT);
   digitalWrite(_pinData, LOW);
@@ -53,8 +58,18 @@ SerialDisplay::SerialDisplay(int pinData, int pinClock, byte qty){
   
   // set default values
   _tosend = false;
+  _rendered = false;
   _inverted = 0;
   _blink_next = 0;
+  _marquee_text = NULL;
+  _marquee_stream = NULL;
+  _marquee_next = 0;
+  _marquee_tail = 0;
+  _send_period = 0; // unlimited
+  _send_last = 0;
+  _deferred = false;
+  _coalesced = 0;
+  _propagation_time = 0;
   for(int i=0 ; i < SERIAL_DISPLAY_MAX_DISPLAYS ; i++){
     _data[i] = 0;
     _state[i] = SERIAL_DISPLAY_OFF;
@@ -73,14 +88,25 @@ boolean SerialDisplay::Blink(word interval, byte display){
   
   // check if turn OFF
   if(interval == 0){
-    if(display == 0){
-      for(int i=0 ; i < _display_qty ; i++)
+    for(int i=0 ; i < _display_qty ; i++){
+      if(((display == 0) || (display == (i + 1))) && (_state[i] & SERIAL_DISPLAY_BLINK)){
         _state[i] &= ~SERIAL_DISPLAY_BLINK; // reset
-    } else {
-      _state[display - 1] &= ~SERIAL_DISPLAY_BLINK; // reset
+        _state[i] |= SERIAL_DISPLAY_ON; // might have stopped in the OFF phase
+      }
+    }
+    
+    // stop the timer only if no other display is blinking
+    boolean blinking = false;
+    for(int i=0 ; i < _display_qty ; i++){
+      if(_state[i] & SERIAL_DISPLAY_BLINK)
+        blinking = true;
     }
+    if(!blinking)
+      _blink_next = 0; // reset
     
-    _blink_next = 0; // reset
+    _tosend = true; // set
+    _rendered = false; // reset
+    Send();
   } else {
     // turn ON
     if(display == 0){
@@ -145,8 +171,9 @@ void SerialDisplay::Cascade(byte type, word interval){
     for(int d=0 ; d < _display_qty ; d++){
       _data[d] = temp[d] & mask;
     }
+    _rendered = false; // reset
     
-    Send();
+    Transmit(); // not limited by the refresh rate (paced by the interval)
     
     delay(interval);
   }
@@ -164,6 +191,7 @@ boolean SerialDisplay::Dot(byte display){
   _data[display - 1] |= PIN_P;
   _state[display - 1] |= SERIAL_DISPLAY_ON;
   _tosend = true; // set
+  _rendered = false; // reset
   Send();
   
   return true;
@@ -182,6 +210,23 @@ byte SerialDisplay::GetData(byte display){
 
 // ----------------------------------------------------------------------------------------------------
 
+// Get the number of frames replaced before being sent (refresh rate)
+unsigned long SerialDisplay::GetCoalesced(void){
+  return _coalesced;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Get the propagation time measured by the last self-test [µs]
+//  (time from the clock edge that shifts the bit out of the chain until it is read back)
+//  NOTE: the resolution is the one of the polling loop (digitalRead() and
+//        micros(), which counts in steps of 4 µs on 16 MHz AVR boards)
+unsigned long SerialDisplay::GetPropagationTime(void){
+  return _propagation_time;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
 // Get the state of the relay (1-based)
 byte SerialDisplay::GetState(byte display){
   // check index
@@ -198,6 +243,8 @@ byte SerialDisplay::GetState(byte display){
 void SerialDisplay::Info(HardwareSerial *stream, byte format){
   stream->print("Qty:");
   stream->println(_display_qty);
+  stream->print("Coalesced:");
+  stream->println(_coalesced);
   for(int i=0 ; i < _display_qty ; i++){
     stream->print('[');
     stream->print(i+1);
@@ -221,14 +268,73 @@ void SerialDisplay::Info(HardwareSerial *stream, byte format){
 // Invert the displays (modules and/or characters)
 void SerialDisplay::Invert(byte type){
   // check if an update is needed
-  if(type != _inverted)
+  if(type != _inverted){
     _tosend = true;
+    _rendered = false; // reset
+  }
   
   _inverted = type;
 }
 
 // ----------------------------------------------------------------------------------------------------
 
+// Scroll a text stored in the flash memory (use the F() macro)
+//  (returns false if invalid parameters)
+//  NOTE: the text is scrolled by Update()
+boolean SerialDisplay::Marquee(const __FlashStringHelper *text, word interval){
+  // check parameters
+  if((text == NULL) || (interval == 0) || (_display_qty == 0))
+    return false;
+  
+  _marquee_text = reinterpret_cast<const char *>(text);
+  _marquee_stream = NULL;
+  MarqueeStart(interval);
+  
+  return true;
+}
+
+// ---------------------------------------
+
+// Scroll the characters read from a stream
+//  (returns false if invalid parameters)
+//  NOTE: the characters are scrolled by Update() as they become available,
+//        until noMarquee() is called
+boolean SerialDisplay::Marquee(Stream *stream, word interval){
+  // check parameters
+  if((stream == NULL) || (interval == 0) || (_display_qty == 0))
+    return false;
+  
+  _marquee_text = NULL;
+  _marquee_stream = stream;
+  MarqueeStart(interval);
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Get the time of the next time based event (compared to millis())
+//  (returns 0 if there is no pending event)
+unsigned long SerialDisplay::NextDeadline(void){
+  unsigned long deadline = 0;
+  
+  // check blink
+  if(_blink_next > 0)
+    deadline = _blink_next;
+  
+  // check marquee
+  if((_marquee_next > 0) && ((deadline == 0) || (_marquee_next < deadline)))
+    deadline = _marquee_next;
+  
+  // check the pending frame
+  if(_deferred && ((deadline == 0) || ((_send_last + _send_period) < deadline)))
+    deadline = _send_last + _send_period;
+  
+  return deadline;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
 // Turn the dot OFF
 //  (returns false if invalid parameters)
 boolean SerialDisplay::noDot(byte display){
@@ -238,6 +344,7 @@ boolean SerialDisplay::noDot(byte display){
   
   _data[display - 1] &= ~PIN_P;
   _tosend = true; // set
+  _rendered = false; // reset
   Send();
   
   return true;
@@ -245,6 +352,15 @@ boolean SerialDisplay::noDot(byte display){
 
 // ----------------------------------------------------------------------------------------------------
 
+// Stop the marquee
+void SerialDisplay::noMarquee(void){
+  _marquee_text = NULL;
+  _marquee_stream = NULL;
+  _marquee_next = 0; // reset
+}
+
+// ----------------------------------------------------------------------------------------------------
+
 // Turn a display OFF
 //  (returns false if invalid parameter)
 //  NOTE: set display to 0 to turn off all displays
@@ -260,6 +376,7 @@ boolean SerialDisplay::Off(byte display){
     _state[display - 1] = SERIAL_DISPLAY_OFF;
   }
   _tosend = true; // set
+  _rendered = false; // reset
   Send();
   
   return true;
@@ -282,6 +399,7 @@ boolean SerialDisplay::On(byte display){
     _state[display - 1] = SERIAL_DISPLAY_ON;
   }
   _tosend = true; // set
+  _rendered = false; // reset
   Send();
   
   return true;
@@ -325,6 +443,7 @@ boolean SerialDisplay::Print(unsigned long value){
     }
   }
   InvertDisplays();
+  _rendered = false; // reset (leading zeroes)
   Send();
   
   return true;
@@ -349,6 +468,20 @@ boolean SerialDisplay::Print(char c, byte display, boolean send){
 
 // ----------------------------------------------------------------------------------------------------
 
+// Set the maximum refresh rate of the displays [Hz]
+//  NOTE: set rate to 0 to send every change immediately
+//  NOTE: the next change is always sent immediately
+void SerialDisplay::RefreshRate(byte rate){
+  if(rate == 0)
+    _send_period = 0; // unlimited
+  else
+    _send_period = 1000 / rate; // [ms]
+  
+  _send_last = millis() - _send_period; // the period has already elapsed
+}
+
+// ----------------------------------------------------------------------------------------------------
+
 // Scroll an array of characters
 //  (returns false if invalid parameters)
 boolean SerialDisplay::Scroll(byte *array, byte array_length, word interval){
@@ -377,8 +510,9 @@ boolean SerialDisplay::Scroll(byte *array, byte array_length, word interval){
     } else {
       _data[_display_qty - 1] = 0; // reset
     }
+    _rendered = false; // reset
     
-    Send(); // send the data
+    Transmit(); // send the data (not limited by the refresh rate)
     
     delay(interval); // wait
   }
@@ -388,6 +522,72 @@ boolean SerialDisplay::Scroll(byte *array, byte array_length, word interval){
 
 // ----------------------------------------------------------------------------------------------------
 
+// Test the chain of displays (the serial output of the last module must be connected to the loopback pin)
+//  (returns 0 if the chain is intact, the first display not reached (1-based),
+//   SERIAL_DISPLAY_FAULT_UNKNOWN if the fault can't be located
+//   or SERIAL_DISPLAY_NONE if there is no loopback pin)
+//  NOTE: a bit is shifted through the chain without latching it, so the
+//        displays are not changed. Only a short (bypassed) chain can be
+//        located, because the bit is read back at the end of the chain.
+//        A lost bit (ex: broken module) or a stuck line is unknown.
+byte SerialDisplay::SelfTest(void){
+  // check pin
+  if((_pinLoopback < 0) || (_display_qty == 0))
+    return SERIAL_DISPLAY_NONE;
+  
+  word length = _display_qty * 8; // [bits]
+  _propagation_time = 0; // reset
+  
+  // clear the chain
+  for(word i=0 ; i < length ; i++)
+    Shift(LOW);
+  if(!WaitLoopback(LOW))
+    return SERIAL_DISPLAY_FAULT_UNKNOWN; // line stuck HIGH
+  
+  // shift a single HIGH bit up to the last bit of the chain
+  Shift(HIGH);
+  for(word count=1 ; count < length ; count++){
+    // check if the bit came back too early (the displays after it were bypassed)
+    if(digitalRead(_pinLoopback) == HIGH)
+      return (count / 8) + 1;
+    
+    if(count < (length - 1)) // the last clock is measured below
+      Shift(LOW);
+  }
+  
+  // shift the bit out of the chain and measure the time until it is read back
+  digitalWrite(_pinData, LOW); // set Data line
+  delayMicroseconds(SERIAL_DISPLAY_DELAY_DATA); // delay between Data and Clock signals
+  digitalWrite(_pinClock, HIGH); // rising edge
+  unsigned long start = micros();
+  boolean found;
+  do {
+    found = (digitalRead(_pinLoopback) == HIGH); // poll during the shift delay (too short to latch)
+  } while(!found && ((micros() - start) < SERIAL_DISPLAY_DELAY_CLOCK_HIGH));
+  unsigned long elapsed = micros() - start;
+  digitalWrite(_pinClock, LOW);
+  if(!found){
+    found = WaitLoopback(HIGH);
+    elapsed = micros() - start;
+  }
+  
+  // check if the bit was lost
+  if(!found)
+    return SERIAL_DISPLAY_FAULT_UNKNOWN;
+  _propagation_time = elapsed; // set
+  
+  // check if the line follows the next bit
+  Shift(LOW);
+  if(!WaitLoopback(LOW)){
+    _propagation_time = 0; // reset
+    return SERIAL_DISPLAY_FAULT_UNKNOWN; // line stuck HIGH
+  }
+  
+  return 0;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
 // Set a display (1-based)
 //  (returns false if invalid parameters)
 //  NOTE: set send to FALSE to manually write to the shift register
@@ -399,6 +599,7 @@ boolean SerialDisplay::Set(byte mask, byte display, boolean send){
   _data[display - 1] = mask;
   _state[display - 1] |= SERIAL_DISPLAY_ON;
   _tosend = true; // set
+  _rendered = false; // reset
   
   InvertChar(display - 1);
   
@@ -426,6 +627,21 @@ boolean SerialDisplay::setBrightnessPin(int pin){
 
 // ----------------------------------------------------------------------------------------------------
 
+// Set the loopback pin for the self-test (serial output of the last display)
+//  (returns false if invalid parameter)
+boolean SerialDisplay::setLoopbackPin(int pin){
+  // check pin
+  if(pin < 0)
+    return false;
+  
+  _pinLoopback = pin;
+  pinMode(_pinLoopback, INPUT);
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
 // Set the pin state on a display (2x 1-based)
 //  (returns false if invalid parameters)
 //  NOTE: set send to FALSE to manually write to the shift register
@@ -441,6 +657,7 @@ boolean SerialDisplay::SetPin(byte pin, byte state, byte display, boolean send){
     _data[display - 1] &= ~pin;
   }
   _tosend = true; // set
+  _rendered = false; // reset
   
   if(send)
     Send();
@@ -450,8 +667,55 @@ boolean SerialDisplay::SetPin(byte pin, byte state, byte display, boolean send){
 
 // ----------------------------------------------------------------------------------------------------
 
-// Update time based functions (blink)
+// Sleep until the next deadline or an interrupt
+//  (returns true if the deadline was reached)
+//  NOTE: call Update() afterwards to process the event
+//  NOTE: the AVR (idle mode) and ARM (WFI) cores sleep, the ESP8266/ESP32
+//        cores idle in delay() and the other cores only yield
+boolean SerialDisplay::Sleep(void){
+  unsigned long deadline = NextDeadline();
+  
+  // check if there is no need to sleep
+  if((deadline > 0) && (millis() > deadline))
+    return true;
+  
+  // NOTE: the MCU is woken up by the millis() tick at least every
+  //       millisecond, so the deadline is never missed
+#if defined(__AVR__)
+  // the idle mode keeps the timers running, so millis() is still valid
+  //  and any interrupt (including the millis() tick) wakes up the MCU
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+#elif defined(__arm__)
+  // wait for interrupt (the SysTick interrupt updates millis())
+  __WFI();
+#elif defined(ESP8266) || defined(ESP32)
+  delay(1); // delay() yields, so the core can idle (ex: modem sleep)
+#else
+  yield(); // no idle mode available
+#endif
+  
+  return ((deadline > 0) && (millis() > deadline));
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Update time based functions (blink, marquee & refresh rate)
 void SerialDisplay::Update(void){
+  // check the pending frame
+  if(_deferred && ((millis() - _send_last) >= _send_period))
+    Transmit();
+  
+  // check marquee
+  if(_marquee_next > 0){
+    if(millis() > _marquee_next){
+      if(MarqueeStep())
+        _marquee_next = millis() + _marquee_interval; // update
+      else
+        _marquee_next = 0; // reset (finished)
+    }
+  }
+  
   // check blink
   if(_blink_next > 0){
     if(millis() > _blink_next){
@@ -465,6 +729,7 @@ void SerialDisplay::Update(void){
           _blink_next = 0; // reset
         }
       }
+      _rendered = false; // reset
       
       Send();
       
@@ -477,7 +742,7 @@ void SerialDisplay::Update(void){
 
 // Write changes
 void SerialDisplay::Write(void){
-  if(_tosend)
+  if(_tosend && !_deferred) // the pending frame already has the changes
     Send();
 }
 
@@ -491,23 +756,8 @@ void SerialDisplay::InvertChar(byte display){
     return;
   
   // invert characters
-  if(_inverted & SERIAL_DISPLAY_INVERT_CHAR){
-    byte temp = _data[display] & (PIN_G | PIN_P);
-    if(_data[display] & PIN_A)
-      temp |= PIN_D;
-    if(_data[display] & PIN_B)
-      temp |= PIN_E;
-    if(_data[display] & PIN_C)
-      temp |= PIN_F;
-    if(_data[display] & PIN_D)
-      temp |= PIN_A;
-    if(_data[display] & PIN_E)
-      temp |= PIN_B;
-    if(_data[display] & PIN_F)
-      temp |= PIN_C;
-    
-    _data[display] = temp;
-  }
+  if(_inverted & SERIAL_DISPLAY_INVERT_CHAR)
+    _data[display] = InvertMask(_data[display]);
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -533,6 +783,126 @@ void SerialDisplay::InvertDisplays(void){
 
 // ----------------------------------------------------------------------------------------------------
 
+// Invert a character mask (upside down)
+byte SerialDisplay::InvertMask(byte mask){
+  byte temp = mask & (PIN_G | PIN_P);
+  if(mask & PIN_A)
+    temp |= PIN_D;
+  if(mask & PIN_B)
+    temp |= PIN_E;
+  if(mask & PIN_C)
+    temp |= PIN_F;
+  if(mask & PIN_D)
+    temp |= PIN_A;
+  if(mask & PIN_E)
+    temp |= PIN_B;
+  if(mask & PIN_F)
+    temp |= PIN_C;
+  
+  return temp;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Start the marquee
+void SerialDisplay::MarqueeStart(word interval){
+  // reset all displays
+  //  (the blink state is kept)
+  for(int i=0 ; i < _display_qty ; i++){
+    _data[i] = 0;
+    _state[i] |= SERIAL_DISPLAY_ON;
+  }
+  
+  _tosend = true; // set
+  _rendered = false; // reset
+  Send(); // clear the displays (a stream might have no character yet)
+  
+  _marquee_tail = 0;
+  _marquee_interval = interval; // set
+  
+  MarqueeStep(); // show the first character
+  _marquee_next = millis() + _marquee_interval; // update
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Scroll the marquee by one character
+//  (returns false if finished)
+//  NOTE: only the characters in the displays are kept in RAM
+boolean SerialDisplay::MarqueeStep(void){
+  int c = -1; // blank
+  
+  // get the next character
+  if(_marquee_text != NULL){
+    c = pgm_read_byte(_marquee_text);
+    if(c == 0){
+      c = -1; // blank
+      _marquee_text = NULL; // end of text
+      _marquee_tail = _display_qty; // scroll the text out
+    } else {
+      _marquee_text++; // update
+    }
+  } else if(_marquee_stream != NULL){
+    if(_marquee_stream->available() <= 0)
+      return true; // wait for new characters
+    c = _marquee_stream->read();
+  }
+  
+  // check for the end of the text
+  if(c < 0){
+    if(_marquee_tail == 0)
+      return false;
+    _marquee_tail--; // update
+  }
+  
+  // shift left
+  for(int d=0 ; d < (_display_qty - 1) ; d++){
+    _data[d] = _data[d+1];
+  }
+  
+  // add the new character
+  _data[_display_qty - 1] = (c < 0) ? 0 : toByteMask(c);
+  InvertChar(_display_qty - 1);
+  _tosend = true; // set
+  _rendered = false; // reset
+  
+  Send(); // send the data
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Shift a bit in the chain (without latching)
+void SerialDisplay::Shift(byte bit){
+  digitalWrite(_pinData, bit); // set Data line
+  delayMicroseconds(SERIAL_DISPLAY_DELAY_DATA); // delay between Data and Clock signals
+  
+  // set Clock line
+  digitalWrite(_pinClock, HIGH); // rising edge
+  delayMicroseconds(SERIAL_DISPLAY_DELAY_CLOCK_HIGH); // shift
+  digitalWrite(_pinClock, LOW);
+  delayMicroseconds(SERIAL_DISPLAY_DELAY_CLOCK_LOW);
+  
+  digitalWrite(_pinData, LOW); // reset to maintain LOW level when not in use
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Wait for a level on the loopback pin
+//  (returns false on timeout)
+boolean SerialDisplay::WaitLoopback(byte level){
+  unsigned long start = micros();
+  while(digitalRead(_pinLoopback) != level){
+    if((micros() - start) >= SERIAL_DISPLAY_SELFTEST_TIMEOUT)
+      return false;
+  }
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
 // Convert a char to printable byte
 //  (returns 0 on failure or the converted char)
 byte SerialDisplay::toByteMask(char c){
@@ -583,49 +953,304 @@ byte SerialDisplay::toByteMask(char c){
 
 // ----------------------------------------------------------------------------------------------------
 
-// Send the data
+// Render the frame to send
+//  NOTE: the frame is stored in transmission order (last display first) and
+//        with the state already applied, so it is only built once per change
+void SerialDisplay::Render(void){
+  byte display_number = (_display_qty != 0) ? _display_qty : 1; // infinite stream uses the first display
+  for(int i=0 ; i < display_number ; i++){
+    _frame[i] = (_state[display_number - 1 - i] & SERIAL_DISPLAY_ON) ? _data[display_number - 1 - i] : 0;
+  }
+  
+  _rendered = true; // set
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Send the data (limited by the refresh rate)
+//  NOTE: if the period of the refresh rate has not elapsed, the frame is
+//        sent later by Update() and replaces any other pending frame
 void SerialDisplay::Send(void){
-  byte mask, data;
-  boolean last_display = false;
-  byte display_number = _display_qty; // start from MAX because the do loop will set it to 0-base at the beginning
-  do {
-    // loop infinite stream or increment
-    if(_display_qty != 0){
-      display_number--;
-      
-      // check for last relay
-      if(display_number == 0)
-        last_display = true;
-    }
+  // check the refresh rate
+  if((_send_period > 0) && ((millis() - _send_last) < _send_period)){
+    if(_deferred)
+      _coalesced++; // the pending frame is replaced
+    _deferred = true; // set
+    return;
+  }
+  
+  Transmit();
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Transmit the data
+void SerialDisplay::Transmit(void){
+  if(!_rendered)
+    Render();
+  
+  byte data;
+  byte last_display = ((_display_qty != 0) ? _display_qty : 1) - 1;
+  for(int d=0 ; d <= last_display ; d++){
+    data = _frame[d];
     
-    // send pulse
-    mask = 0x80; // reset
-    for(int i=1 ; i <= 8 ; i++){
-      data = (_state[display_number] & SERIAL_DISPLAY_ON) ? _data[display_number] : 0; // get the corresponding data
-      
-      // set Data line
-      if(data & mask)
-        digitalWrite(_pinData, HIGH);
-      else
-        digitalWrite(_pinData, LOW);
-      
+    // send pulse (the last bit of the last display is sent with the latch)
+    byte bits = (d == last_display) ? 7 : 8;
+    for(int i=0 ; i < bits ; i++){
+      digitalWrite(_pinData, (data >> 7)); // set Data line (MSB first)
       delayMicroseconds(SERIAL_DISPLAY_DELAY_DATA); // delay between Data and Clock signals
       
       // set Clock line
       digitalWrite(_pinClock, HIGH); // rising edge
-      if((i == 8) && last_display)
-        delayMicroseconds(SERIAL_DISPLAY_DELAY_LATCH); // latch
-      else
-        delayMicroseconds(SERIAL_DISPLAY_DELAY_CLOCK_HIGH); // shift
+      delayMicroseconds(SERIAL_DISPLAY_DELAY_CLOCK_HIGH); // shift
       digitalWrite(_pinClock, LOW);
-      delayMicroseconds(SERIAL_DISPLAY_DELAY_CLOCK_LOW); // it is acceptable to have 5µs delay after the last bit has been sent
+      delayMicroseconds(SERIAL_DISPLAY_DELAY_CLOCK_LOW);
       
-      mask >>= 1; // update mask
+      data <<= 1; // update
     }
-  } while(display_number > 0);
+  }
+  
+  // latch
+  digitalWrite(_pinData, (data >> 7)); // set Data line
+  delayMicroseconds(SERIAL_DISPLAY_DELAY_DATA); // delay between Data and Clock signals
+  digitalWrite(_pinClock, HIGH); // rising edge
+  delayMicroseconds(SERIAL_DISPLAY_DELAY_LATCH); // latch
+  digitalWrite(_pinClock, LOW);
+  delayMicroseconds(SERIAL_DISPLAY_DELAY_CLOCK_LOW); // it is acceptable to have 5µs delay after the last bit has been sent
+  
   digitalWrite(_pinData, LOW); // reset to maintain LOW level when not in use
   
   _tosend = false; // reset
+  _deferred = false; // reset
+  _send_last = millis(); // update
+}
+
+// ----------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------
+
+// Constructor
+//  NOTE: the window is limited to the displays of the parent
+SerialDisplayWindow::SerialDisplayWindow(SerialDisplay *parent, byte offset, byte width, byte align){
+  _parent = parent;
+  _offset = offset;
+  _width = width;
+  _align = align;
+  _inverted = 0;
+  
+  // check the limits
+  if(_offset == 0)
+    _offset = 1;
+  if(_offset > _parent->_display_qty)
+    _width = 0;
+  else if((_offset + _width - 1) > _parent->_display_qty)
+    _width = _parent->_display_qty - _offset + 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Blink a display of the window (1-based)
+//  (returns false if invalid parameter)
+//  NOTE: set display to 0 to blink all displays of the window
+boolean SerialDisplayWindow::Blink(word interval, byte display){
+  // check index
+  if(display > _width)
+    return false;
+  
+  if(display == 0){
+    for(int i=1 ; i <= _width ; i++)
+      _parent->Blink(interval, Map(i));
+  } else {
+    _parent->Blink(interval, Map(display));
+  }
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Turn the dot ON
+//  (returns false if invalid parameters)
+boolean SerialDisplayWindow::Dot(byte display){
+  return _parent->SetPin(SerialDisplay::PIN_P, HIGH, Map(display), false);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Get the data of a display of the window (1-based)
+byte SerialDisplayWindow::GetData(byte display){
+  return _parent->GetData(Map(display));
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Get the state of a display of the window (1-based)
+byte SerialDisplayWindow::GetState(byte display){
+  return _parent->GetState(Map(display));
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Invert the window (displays and/or characters)
+//  NOTE: the character inversion of the parent is also applied, but not
+//        its display inversion (the window keeps its displays in order)
+void SerialDisplayWindow::Invert(byte type){
+  _inverted = type;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Turn the dot OFF
+//  (returns false if invalid parameters)
+boolean SerialDisplayWindow::noDot(byte display){
+  return _parent->SetPin(SerialDisplay::PIN_P, LOW, Map(display), false);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Turn a display of the window OFF
+//  (returns false if invalid parameter)
+//  NOTE: set display to 0 to turn off all displays of the window
+boolean SerialDisplayWindow::Off(byte display){
+  // check index
+  if(display > _width)
+    return false;
+  
+  for(int i=1 ; i <= _width ; i++){
+    if((display == 0) || (display == i))
+      _parent->_state[Map(i) - 1] = SERIAL_DISPLAY_OFF;
+  }
+  _parent->_tosend = true; // set
+  _parent->_rendered = false; // reset
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Turn a display of the window ON
+//  (returns false if invalid parameter)
+//  NOTE: set display to 0 to turn on all displays of the window
+boolean SerialDisplayWindow::On(byte display){
+  // check index
+  if(display > _width)
+    return false;
+  
+  for(int i=1 ; i <= _width ; i++){
+    if((display == 0) || (display == i))
+      _parent->_state[Map(i) - 1] = SERIAL_DISPLAY_ON;
+  }
+  _parent->_tosend = true; // set
+  _parent->_rendered = false; // reset
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Print a value (unsigned long)
+//  (returns false if value is negative)
+boolean SerialDisplayWindow::Print(int value){
+  if(value < 0)
+    return false;
+  
+  return Print((unsigned long)value);
+}
+
+// ---------------------------------------
+
+// Print a value (unsigned long)
+//  (returns true)
+boolean SerialDisplayWindow::Print(word value){
+  return Print((unsigned long)value);
+}
+
+// ---------------------------------------
+
+// Print a value (unsigned long)
+//  (returns false if the window is empty)
+boolean SerialDisplayWindow::Print(unsigned long value){
+  if(_width == 0)
+    return false;
+  
+  // count the digits (the most significant digits are dropped if necessary)
+  byte digits = 1;
+  for(unsigned long temp = value / 10 ; (temp > 0) && (digits < _width) ; temp /= 10)
+    digits++;
+  
+  // get the position of the last digit
+  byte last = (_align == SERIAL_DISPLAY_ALIGN_LEFT) ? digits : _width;
+  
+  for(int i = _width ; i > 0 ; i--){
+    if((i > last) || (i <= (last - digits))){
+      // turn off the unused displays
+      _parent->_data[Map(i) - 1] &= SerialDisplay::PIN_P; // reset, but keep the dot on
+      _parent->_tosend = true; // set
+      _parent->_rendered = false; // reset
+    } else {
+      Print((char)(value % 10), i);
+      value /= 10; // update
+    }
+  }
+  
+  return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Print a character on a display of the window (1-based)
+//  (returns true if valid character)
+boolean SerialDisplayWindow::Print(char c, byte display){
+  byte toprint = _parent->toByteMask(c);
+  
+  // check if valid value
+  if((toprint != 0) && (Map(display) != 0)){
+    toprint |= (GetData(display) & SerialDisplay::PIN_P); // add the dot if necessary
+    return Set(toprint, display);
+  }
+  
+  return false;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Set a display of the window (1-based)
+//  (returns false if invalid parameters)
+boolean SerialDisplayWindow::Set(byte mask, byte display){
+  if(_inverted & SERIAL_DISPLAY_INVERT_CHAR)
+    mask = SerialDisplay::InvertMask(mask);
+  
+  return _parent->Set(mask, Map(display), false);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Set the pin state on a display of the window (2x 1-based)
+//  (returns false if invalid parameters)
+boolean SerialDisplayWindow::SetPin(byte pin, byte state, byte display){
+  return _parent->SetPin(pin, state, Map(display), false);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Write the changes of all windows
+void SerialDisplayWindow::Write(void){
+  _parent->Write();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------------------
+
+// Get the display of the parent (1-based) from a display of the window (1-based)
+//  (returns 0 if invalid display)
+byte SerialDisplayWindow::Map(byte display){
+  // check index
+  if((display == 0) || (display > _width))
+    return 0;
+  
+  if(_inverted & SERIAL_DISPLAY_INVERT_DISPLAY)
+    display = _width + 1 - display;
+  
+  return (_offset + display - 1);
 }
 
 // ----------------------------------------------------------------------------------------------------
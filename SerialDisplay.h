@@ -47,11 +47,15 @@
 #define SERIAL_DISPLAY_DELAY_LATCH       1100 // [µs]
 #endif
 
+#define SERIAL_DISPLAY_SELFTEST_TIMEOUT   500 // [µs]
+
 #define SERIAL_DISPLAY_OFF      0
 #define SERIAL_DISPLAY_ON       1
 #define SERIAL_DISPLAY_BLINK    0x10
 #define SERIAL_DISPLAY_NONE     0xFF
 
+#define SERIAL_DISPLAY_FAULT_UNKNOWN  0xFE
+
 #define SERIAL_DISPLAY_INVERT_NONE     0x00
 #define SERIAL_DISPLAY_INVERT_CHAR     0x01
 #define SERIAL_DISPLAY_INVERT_DISPLAY  0x02
@@ -60,6 +64,9 @@
 #define SERIAL_DISPLAY_CASCADE_UP    0
 #define SERIAL_DISPLAY_CASCADE_DOWN  1
 
+#define SERIAL_DISPLAY_ALIGN_RIGHT  0
+#define SERIAL_DISPLAY_ALIGN_LEFT   1
+
 #define SERIAL_DISPLAY_DEBUG
 
 //#define ENABLE_INFINITE_STREAM
@@ -100,43 +107,110 @@ class SerialDisplay {
     void Brightness(int value);
     void Cascade(byte type, word interval);
     boolean Dot(byte display = 1);
+    unsigned long GetCoalesced(void);
     byte GetData(byte display = 1);
+    unsigned long GetPropagationTime(void);
     byte GetState(byte display = 1);
 #ifdef SERIAL_DISPLAY_DEBUG
     void Info(HardwareSerial *stream, byte format = HEX);
 #endif
     void Invert(byte type = SERIAL_DISPLAY_INVERT_BOTH);
+    boolean Marquee(const __FlashStringHelper *text, word interval);
+    boolean Marquee(Stream *stream, word interval);
+    unsigned long NextDeadline(void);
     boolean noDot(byte display = 1);
+    void noMarquee(void);
     boolean Off(byte display);
     boolean On(byte display);
     boolean Print(int value);
     boolean Print(word value);
     boolean Print(unsigned long value);
     boolean Print(char c, byte display = 1, boolean send = true);
+    void RefreshRate(byte rate);
     boolean Scroll(byte *array, byte array_length, word interval);
+    byte SelfTest(void);
     boolean Set(byte mask, byte display = 1, boolean send = true);
     boolean setBrightnessPin(int pin);
+    boolean setLoopbackPin(int pin);
     boolean SetPin(byte pin, byte state, byte display = 1, boolean send = true);
+    boolean Sleep(void);
     void Update(void);
     void Write(void);
   
   private:
+    friend class SerialDisplayWindow;
+    
     int _pinClock;
     int _pinData;
     int _pinOE;
+    int _pinLoopback;
     byte _display_qty;
     byte _data[SERIAL_DISPLAY_MAX_DISPLAYS];
     byte _state[SERIAL_DISPLAY_MAX_DISPLAYS];
+    byte _frame[SERIAL_DISPLAY_MAX_DISPLAYS]; // rendered data, in transmission order
     byte _inverted;
     byte _brightness;
     word _blink_interval;
     unsigned long _blink_next;
+    const char *_marquee_text; // in PROGMEM
+    Stream *_marquee_stream;
+    word _marquee_interval;
+    unsigned long _marquee_next;
+    byte _marquee_tail; // number of blank characters left to scroll the text out
+    word _send_period; // [ms]
+    unsigned long _send_last;
+    boolean _deferred; // TRUE if a frame is waiting for the refresh rate
+    unsigned long _coalesced;
+    unsigned long _propagation_time; // [µs]
     boolean _tosend; // TRUE if data to send
+    boolean _rendered; // TRUE if the frame is up to date
     
     void InvertChar(byte display);
     void InvertDisplays(void);
+    static byte InvertMask(byte mask);
+    void MarqueeStart(word interval);
+    boolean MarqueeStep(void);
+    void Render(void);
     byte toByteMask(char c);
     void Send(void);
+    void Shift(byte bit);
+    void Transmit(void);
+    boolean WaitLoopback(byte level);
+  
+};
+
+// ----------------------------------------------------------------------------------------------------
+
+// Window over some displays of a SerialDisplay (ex: 3x 4 displays on a chain of 12)
+//  NOTE: the changes are not sent, call Write() once to send the changes of all windows
+//  NOTE: the display inversion of the parent is not applied to the windows
+class SerialDisplayWindow {
+  public:
+    SerialDisplayWindow(SerialDisplay *parent, byte offset, byte width, byte align = SERIAL_DISPLAY_ALIGN_RIGHT);
+    boolean Blink(word interval, byte display = 0);
+    boolean Dot(byte display = 1);
+    byte GetData(byte display = 1);
+    byte GetState(byte display = 1);
+    void Invert(byte type = SERIAL_DISPLAY_INVERT_BOTH);
+    boolean noDot(byte display = 1);
+    boolean Off(byte display);
+    boolean On(byte display);
+    boolean Print(int value);
+    boolean Print(word value);
+    boolean Print(unsigned long value);
+    boolean Print(char c, byte display = 1);
+    boolean Set(byte mask, byte display = 1);
+    boolean SetPin(byte pin, byte state, byte display = 1);
+    void Write(void);
+  
+  private:
+    SerialDisplay *_parent;
+    byte _offset; // first display (1-based)
+    byte _width;
+    byte _align;
+    byte _inverted;
+    
+    byte Map(byte display);
   
 };
 
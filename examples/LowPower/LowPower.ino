@@ -0,0 +1,26 @@
+/*
+      RoboCore - Serial Display example
+                    (19/10/2026)
+
+  Examples of functions in the Serial Display library.
+  The displays blink a value and the MCU sleeps between
+  the blink events instead of spinning in loop().
+  
+*/
+
+#include <SerialDisplay.h>
+
+SerialDisplay displays(4,5,4); // (data, clock, number of modules)
+
+void setup(){
+  displays.Print(1234UL);
+  displays.Blink(500);
+}
+
+
+void loop(){
+  displays.Update();
+  
+  // sleep until the next blink (or any interrupt)
+  displays.Sleep();
+}
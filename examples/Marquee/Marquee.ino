@@ -0,0 +1,31 @@
+/*
+      RoboCore - Serial Display example
+                    (19/10/2026)
+
+  Examples of functions in the Serial Display library.
+  A text stored in the flash memory is scrolled once, then
+  the characters received by the serial port are scrolled
+  as they arrive.
+  
+*/
+
+#include <SerialDisplay.h>
+
+SerialDisplay displays(4,5,4); // (data, clock, number of modules)
+boolean streaming = false;
+
+void setup(){
+  Serial.begin(19200);
+  displays.Marquee(F("C0FFEE-12345-DEAD-BEEF"), 300);
+}
+
+
+void loop(){
+  displays.Update();
+  
+  // scroll the serial data after the text
+  if(!streaming && (displays.NextDeadline() == 0)){
+    displays.Marquee(&Serial, 300);
+    streaming = true;
+  }
+}
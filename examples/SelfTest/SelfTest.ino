@@ -0,0 +1,38 @@
+/*
+      RoboCore - Serial Display example
+                    (19/10/2026)
+
+  Examples of functions in the Serial Display library.
+  The serial output of the last module is connected to
+  pin 7 and the chain of displays is tested every 5 s.
+  
+*/
+
+#include <SerialDisplay.h>
+
+SerialDisplay displays(4,5,4); // (data, clock, number of modules)
+
+void setup(){
+  Serial.begin(19200);
+  displays.setLoopbackPin(7);
+  displays.Print(1234UL);
+}
+
+
+void loop(){
+  byte result = displays.SelfTest();
+  if(result == 0){
+    Serial.print("Chain OK - propagation: ");
+    Serial.print(displays.GetPropagationTime());
+    Serial.println(" us");
+  } else if(result == SERIAL_DISPLAY_FAULT_UNKNOWN){
+    Serial.println("Chain broken (unknown location)");
+  } else if(result == SERIAL_DISPLAY_NONE){
+    Serial.println("No loopback pin");
+  } else {
+    Serial.print("Chain stops before display ");
+    Serial.println(result);
+  }
+  
+  delay(5000);
+}
@@ -0,0 +1,32 @@
+/*
+      RoboCore - Serial Display example
+                    (19/10/2026)
+
+  Examples of functions in the Serial Display library.
+  A chain of 9 displays is split into 3 windows of 3
+  displays, which are sent in a single transmission.
+  
+*/
+
+#include <SerialDisplay.h>
+
+SerialDisplay displays(4,5,9); // (data, clock, number of modules)
+SerialDisplayWindow seconds(&displays, 1, 3); // (parent, first display, number of displays)
+SerialDisplayWindow counter(&displays, 4, 3, SERIAL_DISPLAY_ALIGN_LEFT);
+SerialDisplayWindow analog(&displays, 7, 3);
+word count = 0;
+
+void setup(){
+  displays.Off(0);
+}
+
+
+void loop(){
+  seconds.Print(millis() / 1000);
+  counter.Print(count);
+  analog.Print(analogRead(A0));
+  displays.Write(); // send all windows at once
+  
+  count++;
+  delay(200);
+}
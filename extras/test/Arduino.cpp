@@ -0,0 +1,116 @@
+/*
+  Mock of the Arduino core to test the Serial Display library on host.
+*/
+
+#include "Arduino.h"
+#include "SerialDisplay.h"
+
+MockChain mock_chain;
+unsigned long mock_latches;
+
+static unsigned long _now; // [µs]
+static byte _registers[SERIAL_DISPLAY_MAX_DISPLAYS];
+static int _data;
+static int _clock;
+static unsigned long _edge; // time of the last rising edge [µs]
+static int _output_before_edge;
+
+// ----------------------------------------------------------------------------------------------------
+
+// Get the serial output of the chain
+static int ChainOutput(void){
+  if((mock_chain.modules == 0) || (mock_chain.broken == mock_chain.modules))
+    return LOW;
+  
+  return (_registers[mock_chain.modules - 1] >> 7);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Shift the chain (rising edge of the clock)
+static void ChainShift(void){
+  int in = _data;
+  for(int m=0 ; m < mock_chain.modules ; m++){
+    int out = (mock_chain.broken == (m + 1)) ? LOW : (_registers[m] >> 7);
+    _registers[m] = (_registers[m] << 1) | in;
+    in = out;
+  }
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Reset the time, the pins and the chain (with random data)
+void mock_reset(void){
+  mock_chain.pinData = 4;
+  mock_chain.pinClock = 5;
+  mock_chain.pinLoopback = 7;
+  mock_chain.modules = 4;
+  mock_chain.broken = 0;
+  mock_chain.stuck_high = false;
+  mock_chain.propagation = 0;
+  mock_latches = 0;
+  
+  _now = 0;
+  _data = LOW;
+  _clock = LOW;
+  _edge = 0;
+  _output_before_edge = LOW;
+  for(int i=0 ; i < SERIAL_DISPLAY_MAX_DISPLAYS ; i++)
+    _registers[i] = 0xA5;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+void pinMode(uint8_t, uint8_t){}
+
+void digitalWrite(uint8_t pin, uint8_t value){
+  if(pin == mock_chain.pinData){
+    _data = value ? HIGH : LOW;
+  } else if(pin == mock_chain.pinClock){
+    if(value && !_clock){
+      _output_before_edge = ChainOutput();
+      ChainShift();
+      _edge = _now;
+    } else if(!value && _clock && ((_now - _edge) >= SERIAL_DISPLAY_DELAY_LATCH)){
+      mock_latches++;
+    }
+    _clock = value ? HIGH : LOW;
+  }
+}
+
+int digitalRead(uint8_t pin){
+  _now += MOCK_READ_TIME;
+  
+  if(pin != mock_chain.pinLoopback)
+    return LOW;
+  if(mock_chain.stuck_high)
+    return HIGH;
+  if((_now - _edge) < mock_chain.propagation)
+    return _output_before_edge;
+  
+  return ChainOutput();
+}
+
+void analogWrite(uint8_t, int){}
+
+unsigned long millis(void){
+  return _now / 1000;
+}
+
+unsigned long micros(void){
+  return _now;
+}
+
+void delay(unsigned long ms){
+  _now += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us){
+  _now += us;
+}
+
+void yield(void){}
+
+long map(long value, long from_low, long from_high, long to_low, long to_high){
+  return (value - from_low) * (to_high - to_low) / (from_high - from_low) + to_low;
+}
@@ -0,0 +1,88 @@
+#ifndef RC_SERIAL_DISPLAY_MOCK_ARDUINO_H
+#define RC_SERIAL_DISPLAY_MOCK_ARDUINO_H
+
+/*
+  Mock of the Arduino core to test the Serial Display library on host.
+  
+  The time is simulated (delay() and delayMicroseconds() advance it) and
+  the pins of the displays are connected to a model of a chain of shift
+  registers, configured with mock_chain.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ----------------------------------------------------------------------------------------------------
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+long map(long value, long from_low, long from_high, long to_low, long to_high);
+
+class Print {
+  public:
+    template<typename T> size_t print(T, int = DEC){ return 0; }
+    template<typename T> size_t println(T, int = DEC){ return 0; }
+};
+
+class Stream : public Print {
+  public:
+    virtual ~Stream(){}
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+};
+
+class HardwareSerial : public Stream {
+  public:
+    int available(void){ return 0; }
+    int read(void){ return -1; }
+};
+
+// ----------------------------------------------------------------------------------------------------
+
+// Chain of shift registers (one per display)
+struct MockChain {
+  int pinData;
+  int pinClock;
+  int pinLoopback; // serial output of the last module
+  byte modules; // number of modules connected
+  byte broken; // module (1-based) with its serial output stuck LOW (0 for none)
+  boolean stuck_high; // loopback line stuck HIGH
+  unsigned long propagation; // delay of the serial output after a clock edge [µs]
+};
+
+#define MOCK_READ_TIME  4 // duration of digitalRead() [µs]
+
+extern MockChain mock_chain;
+extern unsigned long mock_latches; // number of latch pulses
+
+void mock_reset(void);
+
+// ----------------------------------------------------------------------------------------------------
+
+#endif // RC_SERIAL_DISPLAY_MOCK_ARDUINO_H
@@ -0,0 +1,115 @@
+/*
+  Host test of SerialDisplay::SelfTest() with a model of the chain of
+  shift registers (see Arduino.h).
+*/
+
+#include <stdio.h>
+#include "SerialDisplay.h"
+
+static int failures = 0;
+
+#define CHECK(condition) do { \
+    if(!(condition)){ \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+      failures++; \
+    } \
+  } while(0)
+
+// ----------------------------------------------------------------------------------------------------
+
+// Run the self-test on a chain of 4 displays
+static byte RunSelfTest(void){
+  SerialDisplay displays(mock_chain.pinData, mock_chain.pinClock, 4);
+  displays.setLoopbackPin(mock_chain.pinLoopback);
+  return displays.SelfTest();
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+static void TestNoLoopbackPin(void){
+  mock_reset();
+  SerialDisplay displays(mock_chain.pinData, mock_chain.pinClock, 4);
+  CHECK(displays.SelfTest() == SERIAL_DISPLAY_NONE);
+  CHECK(!displays.setLoopbackPin(-1));
+}
+
+static void TestIntactChain(void){
+  mock_reset();
+  SerialDisplay displays(mock_chain.pinData, mock_chain.pinClock, 4);
+  displays.setLoopbackPin(mock_chain.pinLoopback);
+  CHECK(displays.SelfTest() == 0);
+  CHECK(mock_latches == 0); // the displays are not changed
+}
+
+static void TestPropagationTime(void){
+  mock_reset();
+  SerialDisplay fast(mock_chain.pinData, mock_chain.pinClock, 4);
+  fast.setLoopbackPin(mock_chain.pinLoopback);
+  CHECK(fast.SelfTest() == 0);
+  CHECK(fast.GetPropagationTime() <= MOCK_READ_TIME); // read back on the first poll
+  
+  mock_reset();
+  mock_chain.propagation = 40;
+  SerialDisplay slow(mock_chain.pinData, mock_chain.pinClock, 4);
+  slow.setLoopbackPin(mock_chain.pinLoopback);
+  CHECK(slow.SelfTest() == 0);
+  CHECK(slow.GetPropagationTime() >= 40);
+  CHECK(slow.GetPropagationTime() < (40 + MOCK_READ_TIME));
+  
+  mock_reset();
+  mock_chain.propagation = 200;
+  SerialDisplay slower(mock_chain.pinData, mock_chain.pinClock, 4);
+  slower.setLoopbackPin(mock_chain.pinLoopback);
+  CHECK(slower.SelfTest() == 0);
+  CHECK(slower.GetPropagationTime() >= 200);
+  CHECK(slower.GetPropagationTime() < (200 + MOCK_READ_TIME));
+}
+
+static void TestTimeout(void){
+  mock_reset();
+  mock_chain.propagation = SERIAL_DISPLAY_SELFTEST_TIMEOUT + 100;
+  CHECK(RunSelfTest() == SERIAL_DISPLAY_FAULT_UNKNOWN);
+}
+
+static void TestShortChain(void){
+  mock_reset();
+  mock_chain.modules = 2; // displays 3 & 4 bypassed
+  CHECK(RunSelfTest() == 3);
+  
+  mock_reset();
+  mock_chain.modules = 1; // displays 2 to 4 bypassed
+  CHECK(RunSelfTest() == 2);
+}
+
+static void TestBrokenModule(void){
+  for(byte module=1 ; module <= 4 ; module++){
+    mock_reset();
+    mock_chain.broken = module;
+    CHECK(RunSelfTest() == SERIAL_DISPLAY_FAULT_UNKNOWN);
+  }
+}
+
+static void TestStuckHigh(void){
+  mock_reset();
+  mock_chain.stuck_high = true;
+  SerialDisplay displays(mock_chain.pinData, mock_chain.pinClock, 4);
+  displays.setLoopbackPin(mock_chain.pinLoopback);
+  CHECK(displays.SelfTest() == SERIAL_DISPLAY_FAULT_UNKNOWN);
+  CHECK(displays.GetPropagationTime() == 0);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+int main(void){
+  TestNoLoopbackPin();
+  TestIntactChain();
+  TestPropagationTime();
+  TestTimeout();
+  TestShortChain();
+  TestBrokenModule();
+  TestStuckHigh();
+  
+  if(failures == 0)
+    printf("OK\n");
+  return (failures == 0) ? 0 : 1;
+}